@@ -128,6 +128,147 @@ namespace {
 	EXPECT_TRUE(profile.allPaths.empty());
 	EXPECT_EQ(1u, profile.inputOutputFlows.size());
   }
+
+  // N1 --> N2
+  // N1 --> N3
+  // N4 --> N2
+  TEST(TudorEmergyTest, CalculateEmergyWithSources) {
+	EmGraphMap graph;
+	graph["N1"]["N2"] = 0.40;
+	graph["N1"]["N3"] = 0.60;
+	graph["N4"]["N2"] = 1.00;
+
+	// S1 has several inputs which must all count toward its outputs
+	EmParams params;
+	params.sourceInputFlows["S1"].insert(parseNodeValue("N1=100"));
+	params.sourceInputFlows["S1"].insert(parseNodeValue("N4=50"));
+	params.sourceInputFlows["S2"].insert(parseNodeValue("N1=10"));
+
+	EmCalcProfile profile;
+	calculateEmergyWithSources(graph, params, profile);
+	EXPECT_EQ(5u, profile.pathCount);
+	EXPECT_EQ(2u, profile.inputOutputFlows.size());
+	EXPECT_NEAR(90.0, profile.inputOutputFlows["S1"]["N2"], 0.0001);
+	EXPECT_NEAR(60.0, profile.inputOutputFlows["S1"]["N3"], 0.0001);
+	EXPECT_NEAR(4.0, profile.inputOutputFlows["S2"]["N2"], 0.0001);
+	EXPECT_NEAR(6.0, profile.inputOutputFlows["S2"]["N3"], 0.0001);
+	EXPECT_EQ(2u, profile.outputFlows.size());
+	EXPECT_NEAR(94.0, profile.outputFlows["N2"], 0.0001);
+	EXPECT_NEAR(66.0, profile.outputFlows["N3"], 0.0001);
+  }
+
+  // same graph as LoopsAndMinflow but resume N7 --> N8 at a lower minflow
+  TEST(TudorEmergyTest, RefineMinflow) {
+	EmGraphMap graph;
+	graph["N1"]["N2"] = 0.40;
+	graph["N1"]["N3"] = 0.60;
+	graph["N3"]["N4"] = 0.90;
+	graph["N3"]["N6"] = 0.10;
+	graph["N4"]["N1"] = 0.50;
+	graph["N4"]["N5"] = 0.50;
+	graph["N6"]["N7"] = 0.10;
+	graph["N6"]["N5"] = 0.90;
+	graph["N7"]["N8"] = 1.00;
+
+	EmParams params;
+	params.saveFrontier = true;
+	params.minBranchFlow = 0.01;
+	params.inputFlows.insert(parseNodeValue("N1=1.0"));
+
+	// first pass keeps the path cut off at N7
+	EmCalcProfile profile;
+	calculateEmergy(graph, params, profile);
+	ASSERT_EQ(1u, profile.frontier.size());
+	EXPECT_EQ("N7", profile.frontier.front().node);
+	EXPECT_NEAR(0.006, profile.frontier.front().flow, 0.0001);
+
+	// refinement expands only the frontier and adds to the outputs
+	params.minBranchFlow = 0.001;
+	EXPECT_EQ(0.0, refineEmergy(graph, params, profile));
+	EXPECT_TRUE(profile.frontier.empty());
+	EXPECT_EQ(0.0, profile.flowLostToMinflow);
+	EXPECT_EQ(4u, profile.pathCount);
+	EXPECT_EQ(4u, profile.maxBranchFlows);
+	EXPECT_EQ(0u, profile.pathMinflowCount);
+	EXPECT_EQ(1u, profile.pathLoopCount);
+	EXPECT_NEAR(0.40, profile.outputFlows["N2"], 0.0001);
+	EXPECT_NEAR(0.324, profile.outputFlows["N5"], 0.0001);
+	EXPECT_NEAR(0.006, profile.outputFlows["N8"], 0.0001);
+	EXPECT_NEAR(0.006, profile.inputOutputFlows["N1"]["N8"], 0.0001);
+
+	// matches a single run at the lower minflow
+	EmCalcProfile direct;
+	calculateEmergy(graph, params, direct);
+	EXPECT_EQ(direct.pathCount, profile.pathCount);
+	EXPECT_NEAR(direct.outputFlows["N8"], profile.outputFlows["N8"], 0.0001);
+  }
+
+  // A --> B --> D --> G
+  //   |     |     |-> H
+  //   |     |-> E --> I
+  //   |-> C --> D
+  //         |-> F --> J
+  TEST(TudorEmergyTest, RefineMinflowWithSources) {
+	EmGraphMap graph;
+	graph["A"]["B"] = 0.3;
+	graph["A"]["C"] = 0.7;
+	graph["B"]["D"] = 0.1;
+	graph["B"]["E"] = 0.9;
+	graph["C"]["D"] = 0.2;
+	graph["C"]["F"] = 0.8;
+	graph["D"]["G"] = 0.3;
+	graph["D"]["H"] = 0.7;
+	graph["E"]["I"] = 1.0;
+	graph["F"]["J"] = 1.0;
+
+	EmParams params;
+	params.saveFrontier = true;
+	params.minBranchFlow = 0.5;
+	params.sourceInputFlows["S1"].insert(parseNodeValue("A=1"));
+	params.sourceInputFlows["S1"].insert(parseNodeValue("C=2"));
+	params.sourceInputFlows["S2"].insert(parseNodeValue("A=3"));
+
+	EmCalcProfile profile;
+	calculateEmergyWithSources(graph, params, profile);
+	ASSERT_FALSE(profile.frontier.empty());
+
+	// each step lowers minflow by 10x: A -> B -> D (0.03 of A) stays cut at 0.05
+	for (int step = 0; step < 2; ++step) {
+	  params.minBranchFlow /= 10.0;
+	  double unexplored = refineEmergy(graph, params, profile);
+	  double frontierFlow = 0.0;
+	  for (EF_cit fcit = profile.frontier.begin(); fcit != profile.frontier.end(); fcit++) {
+		EXPECT_TRUE(fcit->key == "S1" || fcit->key == "S2");
+		frontierFlow += fcit->flow;
+	  }
+	  EXPECT_EQ(frontierFlow, unexplored);
+	  EXPECT_EQ(frontierFlow, profile.flowLostToMinflow);
+	  EXPECT_EQ(profile.frontier.size(), profile.pathMinflowCount);
+	  EXPECT_GE(unexplored, 0.0);
+	  if (step == 0) {
+		EXPECT_FALSE(profile.frontier.empty());
+		EXPECT_GT(unexplored, 0.0);
+	  }
+	}
+	EXPECT_TRUE(profile.frontier.empty());
+	EXPECT_EQ(0.0, profile.flowLostToMinflow);
+
+	// matches a single run at the final minflow
+	EmCalcProfile direct;
+	calculateEmergyWithSources(graph, params, direct);
+	EXPECT_EQ(direct.pathCount, profile.pathCount);
+	EXPECT_EQ(direct.maxBranchFlows, profile.maxBranchFlows);
+	ASSERT_EQ(direct.inputOutputFlows.size(), profile.inputOutputFlows.size());
+	for (EGM_cit cit = direct.inputOutputFlows.begin(); cit != direct.inputOutputFlows.end(); cit++) {
+	  EmNodeValueMap& refined = profile.inputOutputFlows[cit->first];
+	  EXPECT_EQ(cit->second.size(), refined.size());
+	  for (ENVM_cit mcit = cit->second.begin(); mcit != cit->second.end(); mcit++)
+		EXPECT_NEAR(mcit->second, refined[mcit->first], 0.0001);
+	}
+	EXPECT_EQ(direct.outputFlows.size(), profile.outputFlows.size());
+	for (ENVM_cit mcit = direct.outputFlows.begin(); mcit != direct.outputFlows.end(); mcit++)
+	  EXPECT_NEAR(mcit->second, profile.outputFlows[mcit->first], 0.0001);
+  }
 } // namespace
 
 int main(int argc, char** argv) {
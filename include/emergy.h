@@ -33,6 +33,21 @@ namespace tudor_emergy {
   typedef list<EmNodeList> EmPathLists;
   typedef EmPathLists::const_iterator EPL_cit;
 
+  /// \struct EmFrontierPath
+  /// \brief a partial path abandoned because its flow fell below minflow
+  /// \note enough state is kept to resume the path at a lower minflow
+  struct EmFrontierPath {
+	string key;					/// entry in inputOutputFlows (input or source)
+	string node;				/// node where the path was cut off
+	double flow;				/// flow arriving at node
+	double inputFlow;			/// input flow that minBranchFlow scales
+	EmNodeSet pathSet;			/// nodes already on the path for loop checks
+	EmNodeList pathList;		/// path so far (only populated with savePaths)
+	EmFrontierPath() : flow(0.0), inputFlow(0.0) { /* empty */ }
+  };
+  typedef list<EmFrontierPath> EmFrontier;
+  typedef EmFrontier::const_iterator EF_cit;
+
   /// \struct EmCalcProfile 
   /// \brief profile a run of the calculator
   /// \note maxBranchFlows = maxPathLen-1
@@ -46,6 +61,7 @@ namespace tudor_emergy {
 	EmPathLists allPaths;		/// only populate this if requested in EmParams
 	EmNodeValueMap outputFlows;
 	EmGraphMap inputOutputFlows; /// [input => (output=value)]
+	EmFrontier frontier;		/// only populated if saveFrontier in EmParams
 	EmCalcProfile();
   };
 
@@ -53,13 +69,16 @@ namespace tudor_emergy {
   /// \brief parameters for a run of the calculator
   /// \param minBranchFlow sets a cutoff for whether to branch flow to
   /// child nodes
+  /// \param saveFrontier keeps paths cut off by minBranchFlow so that
+  /// refineEmergy can resume them at a lower cutoff
   struct EmParams {
 	bool savePaths;				// should all the paths be saved?
 	bool printSources;			// should sources be printed for each output?
+	bool saveFrontier;			// should minflow violations be kept for refinement?
 	double minBranchFlow;
 	EmGraphMap sourceInputFlows; /// [source => (input=value)]
 	EmNodeValueMap inputFlows;
-	EmParams() : savePaths(false), printSources(false), minBranchFlow(0.0) { /* empty */ }
+	EmParams() : savePaths(false), printSources(false), saveFrontier(false), minBranchFlow(0.0) { /* empty */ }
   };
 
   /// calculate the emergy of a system in graph and populate a run profile
@@ -70,6 +89,15 @@ namespace tudor_emergy {
 
   void calculateEmergyWithSources(const EmGraphMap& graph, const EmParams& params, EmCalcProfile& profile);
 
+  /// resume the paths in profile.frontier using the (lower) params.minBranchFlow
+  /// \brief adds to the outputs of a previous run made with saveFrontier set
+  /// \param graph the same graph used for the previous run
+  /// \param params parameters for the previous run with minBranchFlow lowered
+  /// \param profile the results of the previous run to be refined
+  /// \return flow still unexplored because of minflow violations, i.e. the
+  /// sum of the flows left in profile.frontier (0.0 once it is empty)
+  double refineEmergy(const EmGraphMap& graph, const EmParams& params, EmCalcProfile& profile);
+
   /// read a graph from a file
   /// \brief read the graph in form N1 N2 split in [0.0, 1.0]
   /// \param filename a file with format: parent child branch
@@ -115,7 +115,8 @@ namespace tudor_emergy {
 
   /// legacy implementation only @TODO replace with non-recursive version
   /// \note pathlist is *NOT* a reference and is passed by value
-  void pathBuild(const string& node, const EmGraphMap& g, EmNodeSet& pathset, EmNodeValueMap& outputs, double flow, EmNodeList pathlist, double minflow, EmCalcProfile& profile, const EmParams& params) {
+  /// \note key and inputFlow are only recorded on frontier paths
+  void pathBuild(const string& node, const EmGraphMap& g, EmNodeSet& pathset, EmNodeValueMap& outputs, double flow, EmNodeList pathlist, double minflow, EmCalcProfile& profile, const EmParams& params, const string& key, double inputFlow) {
 	if (g.find(node) == g.end()) { // no child so aggregate flow
 	  outputs[node] += flow;
 	  if (pathset.size() > profile.maxBranchFlows)
@@ -130,6 +131,16 @@ namespace tudor_emergy {
 	else if (flow < minflow) { // bail out of calculations with too small flow
 	  profile.flowLostToMinflow += flow;
 	  ++profile.pathMinflowCount;
+	  if (params.saveFrontier) { // keep the path to resume at a lower minflow
+		EmFrontierPath fp;
+		fp.key = key;
+		fp.node = node;
+		fp.flow = flow;
+		fp.inputFlow = inputFlow;
+		fp.pathSet = pathset;
+		fp.pathList = pathlist;
+		profile.frontier.push_back(fp);
+	  }
 	  return;
 	}
 	else {						// update path and recurse
@@ -143,7 +154,7 @@ namespace tudor_emergy {
 		  profile.flowLostToLoops += cit->second * flow;
 		}	// end path because it loops back to previous point in its path
 		else {
-		  pathBuild(cit->first, g, pathset, outputs, cit->second * flow, pathlist, minflow, profile, params);
+		  pathBuild(cit->first, g, pathset, outputs, cit->second * flow, pathlist, minflow, profile, params, key, inputFlow);
 		}
 	  }
 	  pathset.erase(node);		// return path to previous state
@@ -159,13 +170,12 @@ namespace tudor_emergy {
 	  // process all inputs
 	  const EmNodeValueMap& inputs = scit->second;
 
+	  // accumulate outputs of every input under its source
+	  EmNodeValueMap& outputMap = inputOutputs[scit->first];
 	  EmNodeSet pathSet;
 	  EmNodeList pathList;
-	  for (ENVM_cit cit = inputs.begin(); cit != inputs.end(); cit++) {
-		EmNodeValueMap outputMap;
-		pathBuild(cit->first, graph, pathSet, outputMap, cit->second, pathList, params.minBranchFlow * cit->second, profile, params);
-		inputOutputs.insert(EmGraphMapEntry(scit->first, outputMap));
-	  }
+	  for (ENVM_cit cit = inputs.begin(); cit != inputs.end(); cit++)
+		pathBuild(cit->first, graph, pathSet, outputMap, cit->second, pathList, params.minBranchFlow * cit->second, profile, params, scit->first, cit->second);
 	}
 
 	// now aggregate all the input-output flows
@@ -187,7 +197,7 @@ namespace tudor_emergy {
 	EmNodeList pathList;
 	for (ENVM_cit cit = inputs.begin(); cit != inputs.end(); cit++) {
 	  EmNodeValueMap outputMap;
-	  pathBuild(cit->first, graph, pathSet, outputMap, cit->second, pathList, params.minBranchFlow * cit->second, profile, params);
+	  pathBuild(cit->first, graph, pathSet, outputMap, cit->second, pathList, params.minBranchFlow * cit->second, profile, params, cit->first, cit->second);
 	  inputOutputs.insert(EmGraphMapEntry(cit->first, outputMap));
 	}
 
@@ -201,4 +211,40 @@ namespace tudor_emergy {
 		  outputs[mcit->first] += mcit->second;
 	  }
   }
+
+  // expand only the paths cut off by the previous minflow and add their
+  // outputs to the existing results
+  double refineEmergy(const EmGraphMap& graph, const EmParams& params, EmCalcProfile& profile) {
+	if (profile.frontier.empty()) // nothing saved to resume
+	  return profile.flowLostToMinflow;
+
+	// every minflow violation of a run with saveFrontier is on the frontier,
+	// so restart the minflow statistics and let pathBuild count the paths
+	// cut off again (subtracting resumed flows leaves rounding residue)
+	EmFrontier frontier;
+	frontier.swap(profile.frontier); // pathBuild refills profile.frontier
+	profile.flowLostToMinflow = 0.0;
+	profile.pathMinflowCount = 0;
+	for (EF_cit fcit = frontier.begin(); fcit != frontier.end(); fcit++) {
+	  EmNodeSet pathSet = fcit->pathSet;
+	  EmNodeValueMap outputMap;
+	  pathBuild(fcit->node, graph, pathSet, outputMap, fcit->flow, fcit->pathList, params.minBranchFlow * fcit->inputFlow, profile, params, fcit->key, fcit->inputFlow);
+
+	  // add refined flows to both the per input and aggregate outputs
+	  EmNodeValueMap& inputOutputs = profile.inputOutputFlows[fcit->key];
+	  for (ENVM_cit mcit = outputMap.begin(); mcit != outputMap.end(); mcit++) {
+		inputOutputs[mcit->first] += mcit->second;
+		profile.outputFlows[mcit->first] += mcit->second;
+	  }
+	}
+
+	// unexplored flow is exactly what remains on the new frontier
+	if (params.saveFrontier) {
+	  double unexplored = 0.0;
+	  for (EF_cit fcit = profile.frontier.begin(); fcit != profile.frontier.end(); fcit++)
+		unexplored += fcit->flow;
+	  profile.flowLostToMinflow = unexplored;
+	}
+	return profile.flowLostToMinflow;
+  }
 } // tudor_emergy
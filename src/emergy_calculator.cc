@@ -33,7 +33,7 @@ using tudor_emergy::parseNodeValue;
 using tudor_emergy::EmNodeValue;
 using tudor_emergy::EmGraphMapEntry;
 void print_usage(const char* progname) {
-	std::cerr << "USAGE: " << progname << " -g <graph file> -i <input file> -m [flow multiplier=0.0] -p[rint sources]" << std::endl; 
+	std::cerr << "USAGE: " << progname << " -g <graph file> -i <input file> -m [flow multiplier=0.0] -r [refinement steps=0] -p[rint sources]" << std::endl; 
 }
 
 int main(int argc, char **argv) {
@@ -44,10 +44,11 @@ int main(int argc, char **argv) {
   // setup parameters
   EmParams params;
   params.savePaths = false;
+  int refineSteps = 0;			// each step lowers minBranchFlow by 10x
 
   int c = -1;
   opterr = 0;
-  while ((c = getopt(argc, argv, "+g:i:m:ph")) != -1) {
+  while ((c = getopt(argc, argv, "+g:i:m:r:ph")) != -1) {
 	switch(c) {
 	case 'h':
 	  print_usage(argv[0]);
@@ -62,6 +63,10 @@ int main(int argc, char **argv) {
 	case 'm':
 	  params.minBranchFlow = atof(optarg);
 	  break;
+	case 'r':
+	  refineSteps = atoi(optarg);
+	  params.saveFrontier = refineSteps > 0;
+	  break;
 	case 'p':
 	  params.printSources = true;
 	  break;
@@ -116,6 +121,14 @@ int main(int argc, char **argv) {
   // run the calculator
   calculateEmergyWithSources(graph, params, profile);
 
+  // resume minflow violations at successively lower thresholds
+  for (int step = 0; step < refineSteps && !profile.frontier.empty(); ++step) {
+	params.minBranchFlow /= 10.0;
+	double unexplored = refineEmergy(graph, params, profile);
+	std::cerr << "refine: minFlow = " << params.minBranchFlow
+			  << " unexplored flow = " << unexplored << std::endl;
+  }
+
   // dump number of paths examined
   std::cout << std::endl << "STATISTICS:" << std::endl;
   std::cout << "longest path: " << profile.maxBranchFlows << std::endl;